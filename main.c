@@ -5,6 +5,8 @@
 #include "hardware/pio.h"
 #include "hardware/clocks.h"
 #include "hardware/adc.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
 #include "pico/bootrom.h"
 
 // arquivo .pio
@@ -25,15 +27,32 @@ const char key_map[rows][cols] = {
     {'*', '0', '#', 'D'}  // Quarta linha
 };
 
+// O teclado é varrido pelo programa keypad da pio1 (a pio0 fica com a matriz de LEDs)
+#define KEYPAD_PIO pio1
+#define KEYPAD_SCAN_HZ 1000    // Varreduras completas do teclado por segundo
+#define KEYPAD_DEBOUNCE_MS 20  // Tempo que o bitmap precisa ficar estável para ser aceito
+
+static uint keypad_sm;
+static volatile uint16_t keypad_bitmap = 0;    // Último bitmap enviado pela PIO
+static volatile uint32_t keypad_changed_ms = 0; // Instante em que o bitmap mudou
+
+// Interrupção da pio1: a PIO só envia o bitmap quando ele muda
+static void keypad_irq_handler()
+{
+    while (!pio_sm_is_rx_fifo_empty(KEYPAD_PIO, keypad_sm))
+    {
+        keypad_bitmap = pio_sm_get(KEYPAD_PIO, keypad_sm);
+        keypad_changed_ms = to_ms_since_boot(get_absolute_time());
+    }
+}
+
 // Inicialização do teclado matricial
 void keypad_init()
 {
-    // Inicializa as linhas do teclado (como saídas)
+    // As linhas passam a ser controladas pela PIO
     for (int i = 0; i < rows; i++)
     {
-        gpio_init(row_pins[i]);
-        gpio_set_dir(row_pins[i], GPIO_OUT);
-        gpio_put(row_pins[i], false); // Inicializa as linhas como LOW
+        pio_gpio_init(KEYPAD_PIO, row_pins[i]);
     }
 
     // Inicializa as colunas do teclado (como entradas) com pull-down
@@ -43,25 +62,38 @@ void keypad_init()
         gpio_set_dir(col_pins[i], GPIO_IN);
         gpio_pull_down(col_pins[i]); // Garante que a leitura seja 0 quando não pressionado
     }
+
+    // Carrega o programa de varredura e entrega o bitmap à CPU por interrupção
+    uint offset = pio_add_program(KEYPAD_PIO, &keypad_program);
+    keypad_sm = pio_claim_unused_sm(KEYPAD_PIO, true);
+    pio_set_irq0_source_enabled(KEYPAD_PIO, pis_sm0_rx_fifo_not_empty + keypad_sm, true);
+    irq_set_exclusive_handler(PIO1_IRQ_0, keypad_irq_handler);
+    irq_set_enabled(PIO1_IRQ_0, true);
+    keypad_program_init(KEYPAD_PIO, keypad_sm, offset, KEYPAD_SCAN_HZ);
 }
 
 // Leitura das teclas pressionadas no teclado matricial
 char read_keypad()
 {
+    uint32_t status = save_and_disable_interrupts();
+    uint16_t bitmap = keypad_bitmap;
+    uint32_t changed_ms = keypad_changed_ms;
+    restore_interrupts(status);
+
+    // Enquanto o bitmap estiver oscilando, nenhuma tecla é considerada
+    if (to_ms_since_boot(get_absolute_time()) - changed_ms < KEYPAD_DEBOUNCE_MS)
+        return '\0';
+
+    // Bit 15 é R1/C1 e bit 0 é R4/C4
     for (int row = 0; row < rows; row++)
     {
-        gpio_put(row_pins[row], 1); // Ativa uma linha de cada vez
-
         for (int col = 0; col < cols; col++)
         {
-            if (gpio_get(col_pins[col]))
-            {                               // Se a tecla correspondente for pressionada
-                gpio_put(row_pins[row], 0); // Desativa a linha após detectar a tecla
-                sleep_ms(20);               // Espera um curto período para estabilizar a leitura
-                return key_map[row][col];   // Retorna o valor da tecla pressionada
+            if (bitmap & (1u << (15 - (row * cols + col))))
+            {                             // Se a tecla correspondente estiver pressionada
+                return key_map[row][col]; // Retorna o valor da tecla pressionada
             }
         }
-        gpio_put(row_pins[row], 0); // Desativa a linha
     }
     return '\0'; // Retorna '\0' se nenhuma tecla for pressionada
 }
@@ -575,11 +607,12 @@ int main()
     double r = 0.0, b = 0.0, g = 0.0;
     //
     stdio_init_all(); // Inicializa a comunicação com o terminal
-    keypad_init();    // Inicializa o teclado matricial
 
     // coloca a frequência de clock para 128 MHz, facilitando a divisão pelo clock
     ok = set_sys_clock_khz(128000, false);
 
+    keypad_init(); // Inicializa o teclado matricial (depois do clock, para a taxa de varredura ficar certa)
+
     // Inicializa todos os códigos stdio padrão que estão ligados ao binário.
     stdio_init_all();
 